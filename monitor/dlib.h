@@ -17,6 +17,7 @@
 
 dlib_handle_t load_dlib_or_halt(std::string_view lib_name);
 dfunc_handle_t load_dfunc_or_halt(dlib_handle_t lib_handle, std::string_view func_name);
+dfunc_handle_t maybe_load_dfunc(dlib_handle_t lib_handle, std::string_view func_name);
 void unload_dlib(dlib_handle_t lib_handle);
 
 #endif //_NVIDIA_GPU_MONITOR_DLIB_H
\ No newline at end of file
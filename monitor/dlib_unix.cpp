@@ -1,3 +1,5 @@
+#include <string>
+
 #include "dlib_unix.h"
 #include "utils.h"
 
@@ -30,6 +32,11 @@ dfunc_handle_t load_dfunc_or_halt(dlib_handle_t lib_handle, std::string_view fun
 }
 
 
+dfunc_handle_t maybe_load_dfunc(dlib_handle_t lib_handle, std::string_view func_name) {
+  return dlsym(lib_handle, func_name.data());
+}
+
+
 void unload_dlib(dlib_handle_t lib_handle) {
   dlclose(lib_handle);
 }
\ No newline at end of file
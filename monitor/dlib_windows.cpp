@@ -1,3 +1,5 @@
+#include <string>
+
 #include "dlib_windows.h"
 #include "utils.h"
 
@@ -29,6 +31,11 @@ dfunc_handle_t load_dfunc_or_halt(dlib_handle_t lib_handle, std::string_view fun
 }
 
 
+dfunc_handle_t maybe_load_dfunc(dlib_handle_t lib_handle, std::string_view func_name) {
+  return GetProcAddress(lib_handle, func_name.data());
+}
+
+
 void unload_dlib(dlib_handle_t lib_handle) {
   FreeLibrary(lib_handle);
 }
\ No newline at end of file
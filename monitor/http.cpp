@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include "http.h"
+
+
+constexpr std::string_view HEADERS_END{"\r\n\r\n"};
+constexpr std::string_view LINE_END{"\r\n"};
+constexpr std::string_view CHUNKED_BODY_END{"0\r\n\r\n"};
+
+
+static bool starts_with_ignoring_case(std::string_view value, std::string_view prefix) {
+  return value.size() >= prefix.size() && std::equal(
+    prefix.begin(), prefix.end(), value.begin(),
+    [](char a, char b) { return std::tolower(a) == std::tolower(b); }
+  );
+}
+
+
+static bool contains_ignoring_case(std::string_view value, std::string_view needle) {
+  return std::search(
+    value.begin(), value.end(), needle.begin(), needle.end(),
+    [](char a, char b) { return std::tolower(a) == std::tolower(b); }
+  ) != value.end();
+}
+
+
+HTTPConnection::HTTPConnection(
+  std::string_view host,
+  const unsigned short port,
+  const std::chrono::milliseconds timeout
+): host{host},
+   port{port},
+   timeout{timeout}
+{
+  init_net_or_halt();
+}
+
+
+HTTPConnection::~HTTPConnection() {
+  maybe_disconnect();
+}
+
+
+bool HTTPConnection::maybe_connect() {
+  if (socket == INVALID_SOCKET_HANDLE) {
+    socket = maybe_connect_socket(host, port, timeout);
+  }
+  return socket != INVALID_SOCKET_HANDLE;
+}
+
+
+void HTTPConnection::maybe_disconnect() {
+  if (socket != INVALID_SOCKET_HANDLE) {
+    close_socket(socket);
+    socket = INVALID_SOCKET_HANDLE;
+  }
+}
+
+
+std::optional<unsigned int> HTTPConnection::maybe_post(
+  std::string_view path,
+  std::string_view extra_headers,
+  std::string_view body
+) {
+  request.clear();
+  request.append("POST ").append(path).append(" HTTP/1.1\r\n")
+         .append("Host: ").append(host).append(":").append(std::to_string(port)).append(LINE_END)
+         .append("Connection: keep-alive\r\n")
+         .append("Content-Type: text/plain; charset=utf-8\r\n")
+         .append("Content-Length: ").append(std::to_string(body.size())).append(LINE_END)
+         .append(extra_headers)
+         .append(LINE_END);
+
+  // a kept-alive connection may have been closed by the server while idle,
+  // so a failure on a reused connection is retried once on a fresh one
+  const bool reused{socket != INVALID_SOCKET_HANDLE};
+
+  if (auto status = maybe_exchange(body); status.has_value() || !reused) {
+    return status;
+  }
+
+  return maybe_exchange(body);
+}
+
+
+std::optional<unsigned int> HTTPConnection::maybe_exchange(std::string_view body) {
+  if (!maybe_connect()) {
+    return std::nullopt;
+  }
+
+  unsigned int status{0};
+  bool keep_alive{true};
+
+  if (
+    !send_all(socket, request.data(), request.size()) ||
+    !send_all(socket, body.data(), body.size()) ||
+    !maybe_receive_response(status, keep_alive)
+  ) {
+    maybe_disconnect();
+    return std::nullopt;
+  }
+
+  if (!keep_alive) {
+    maybe_disconnect();
+  }
+
+  return status;
+}
+
+
+bool HTTPConnection::maybe_receive_more() {
+  char buffer[HTTP_RECEIVE_BUFFER_SIZE];
+
+  const auto received = receive_some(socket, buffer, HTTP_RECEIVE_BUFFER_SIZE);
+  if (received <= 0) {
+    return false;
+  }
+
+  response.append(buffer, static_cast<size_t>(received));
+  return true;
+}
+
+
+bool HTTPConnection::maybe_receive_response(unsigned int& status, bool& keep_alive) {
+  response.clear();
+
+  size_t headers_end{std::string::npos};
+  while ((headers_end = response.find(HEADERS_END)) == std::string::npos) {
+    if (!maybe_receive_more()) {
+      return false;
+    }
+  }
+
+  const std::string_view headers{response.data(), headers_end + LINE_END.size()};
+  if (!starts_with_ignoring_case(headers, "HTTP/1.")) {
+    return false;
+  }
+
+  // "HTTP/1.1 204 No Content"
+  status = static_cast<unsigned int>(std::strtoul(response.c_str() + headers.find(' ') + 1, NULL, 10));
+  keep_alive = !starts_with_ignoring_case(headers, "HTTP/1.0");
+
+  std::optional<size_t> content_length;
+  bool chunked{false};
+
+  for (
+    size_t line_begin = headers.find(LINE_END) + LINE_END.size(), line_end;
+    (line_end = headers.find(LINE_END, line_begin)) != std::string_view::npos;
+    line_begin = line_end + LINE_END.size()
+  ) {
+    const auto line = headers.substr(line_begin, line_end - line_begin);
+
+    if (starts_with_ignoring_case(line, "Content-Length:")) {
+      content_length = std::strtoul(std::string(line.substr(15)).c_str(), NULL, 10);
+    } else if (starts_with_ignoring_case(line, "Transfer-Encoding:")) {
+      chunked = contains_ignoring_case(line, "chunked");
+    } else if (starts_with_ignoring_case(line, "Connection:")) {
+      keep_alive = !contains_ignoring_case(line, "close");
+    }
+  }
+
+  const size_t body_begin{headers_end + HEADERS_END.size()};
+
+  if (chunked) {
+    // the body is discarded, so it is enough to wait for the last chunk
+    while (
+      response.size() < body_begin + CHUNKED_BODY_END.size() ||
+      response.compare(response.size() - CHUNKED_BODY_END.size(), CHUNKED_BODY_END.size(), CHUNKED_BODY_END) != 0
+    ) {
+      if (!maybe_receive_more()) {
+        return false;
+      }
+    }
+  } else if (content_length.has_value()) {
+    while (response.size() < body_begin + content_length.value()) {
+      if (!maybe_receive_more()) {
+        return false;
+      }
+    }
+  } else if (status >= 200 && status != 204 && status != 304) {
+    // body is delimited by connection close
+    while (maybe_receive_more()) {
+    }
+    keep_alive = false;
+  }
+
+  return true;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef _NVIDIA_GPU_MONITOR_HTTP_H
+#define _NVIDIA_GPU_MONITOR_HTTP_H
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "net.h"
+
+
+constexpr size_t HTTP_RECEIVE_BUFFER_SIZE{4096};
+
+
+// Minimal HTTP/1.1 client keeping a single connection alive between requests.
+class HTTPConnection {
+  public:
+    HTTPConnection(
+      std::string_view host,
+      const unsigned short port,
+      const std::chrono::milliseconds timeout
+    );
+    ~HTTPConnection();
+
+    HTTPConnection(const HTTPConnection&) = delete;
+    HTTPConnection& operator=(const HTTPConnection&) = delete;
+
+    // Returns response status code or nothing if the request could not be
+    // delivered or the response could not be read.
+    std::optional<unsigned int> maybe_post(
+      std::string_view path,
+      std::string_view extra_headers,
+      std::string_view body
+    );
+
+  private:
+    bool maybe_connect();
+    void maybe_disconnect();
+    std::optional<unsigned int> maybe_exchange(std::string_view body);
+    bool maybe_receive_response(unsigned int& status, bool& keep_alive);
+    bool maybe_receive_more();
+
+    const std::string host;
+    const unsigned short port;
+    const std::chrono::milliseconds timeout;
+
+    socket_handle_t socket{INVALID_SOCKET_HANDLE};
+
+    std::string request;  // reused between requests
+    std::string response; // reused between requests
+};
+
+
+#endif // _NVIDIA_GPU_MONITOR_HTTP_H
\ No newline at end of file
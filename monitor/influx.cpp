@@ -0,0 +1,443 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "config.h"
+#include "influx.h"
+#include "utils.h"
+
+#ifdef HAVE_ZLIB
+  #include <zlib.h>
+#endif
+
+
+constexpr auto SPILL_REPLAY_SUFFIX{".replay"};
+constexpr long long NANOS_IN_MILLI{1000000};
+
+
+static void append_number(std::string& buffer, const unsigned long long value) {
+  char digits[24];
+  const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+  buffer.append(digits, result.ptr);
+}
+
+
+static void append_integer_field(std::string& buffer, const char* name, const unsigned long long value) {
+  buffer.append(name).push_back('=');
+  append_number(buffer, value);
+  buffer.push_back('i');
+}
+
+
+static void append_timestamp(std::string& buffer, const std::chrono::milliseconds timestamp) {
+  // default precision of InfluxDB is nanoseconds
+  buffer.push_back(' ');
+  append_number(buffer, static_cast<unsigned long long>(timestamp.count() * NANOS_IN_MILLI));
+  buffer.push_back('\n');
+}
+
+
+static void append_escaped_tag_value(std::string& buffer, std::string_view value) {
+  for (const auto c : value) {
+    if (c == ',' || c == '=' || c == ' ') {
+      buffer.push_back('\\');
+    }
+    buffer.push_back(c);
+  }
+}
+
+
+void encode_influx_line(
+  std::string& buffer,
+  const std::chrono::milliseconds timestamp,
+  const NVMLDevice::info_t& info
+) {
+  buffer.append(INFLUX_MEASUREMENT).append(",index=");
+  append_number(buffer, info.index);
+  buffer.append(",name=");
+  append_escaped_tag_value(buffer, info.name);
+  buffer.push_back(' ');
+
+  append_integer_field(buffer, "fan_speed", info.metrics.fan_speed);
+  buffer.push_back(',');
+  append_integer_field(buffer, "temperature", info.metrics.temperature);
+  buffer.push_back(',');
+  append_integer_field(buffer, "power_usage", info.metrics.power_usage);
+  buffer.push_back(',');
+  append_integer_field(buffer, "gpu_utilization", info.metrics.gpu_utilization);
+  buffer.push_back(',');
+  append_integer_field(buffer, "memory_utilization", info.metrics.memory_utilization);
+  buffer.push_back(',');
+  append_integer_field(buffer, "total_energy_mj", info.metrics.total_energy);
+  buffer.push_back(',');
+  append_integer_field(buffer, "energy_delta_mj", info.metrics.energy_delta);
+
+  append_timestamp(buffer, timestamp);
+}
+
+
+void encode_influx_line(
+  std::string& buffer,
+  const std::chrono::milliseconds timestamp,
+  const ProcessOverheadMeter::overhead_t& overhead
+) {
+  buffer.append(INFLUX_OVERHEAD_MEASUREMENT).push_back(' ');
+
+  append_integer_field(buffer, "interval", static_cast<unsigned long long>(overhead.interval.count()));
+  buffer.push_back(',');
+  append_integer_field(buffer, "user_time", static_cast<unsigned long long>(overhead.user_time.count()));
+  buffer.push_back(',');
+  append_integer_field(buffer, "system_time", static_cast<unsigned long long>(overhead.system_time.count()));
+  buffer.append(",cpu_percent=").append(std::to_string(overhead.cpu_percent)).push_back(',');
+  append_integer_field(buffer, "voluntary_context_switches", overhead.voluntary_context_switches);
+  buffer.push_back(',');
+  append_integer_field(buffer, "involuntary_context_switches", overhead.involuntary_context_switches);
+  buffer.push_back(',');
+  append_integer_field(buffer, "rss", overhead.rss);
+
+  append_timestamp(buffer, timestamp);
+}
+
+
+#ifdef HAVE_ZLIB
+static bool maybe_gzip(std::string_view input, std::string& output) {
+  z_stream stream{};
+
+  // 16 added to window bits selects gzip wrapper instead of zlib one
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    return false;
+  }
+
+  output.resize(deflateBound(&stream, static_cast<uLong>(input.size())));
+
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = static_cast<uInt>(input.size());
+  stream.next_out = reinterpret_cast<Bytef*>(output.data());
+  stream.avail_out = static_cast<uInt>(output.size());
+
+  const auto status = deflate(&stream, Z_FINISH);
+  output.resize(stream.total_out);
+  deflateEnd(&stream);
+
+  return status == Z_STREAM_END;
+}
+#endif
+
+
+InfluxSink::InfluxSink(const config_t& config)
+: config{config},
+  connection{config.host, config.port, config.timeout},
+  retry_backoff{config.retry_backoff}
+{
+#ifndef HAVE_ZLIB
+  if (config.compress) {
+    halt("compression of InfluxDB batches is not supported: monitor is built without zlib");
+  }
+#endif
+
+  if (!config.token.empty()) {
+    headers.append("Authorization: Token ").append(config.token).append("\r\n");
+  }
+  if (config.compress) {
+    headers.append("Content-Encoding: gzip\r\n");
+  }
+
+  // leftovers of a previous run are replayed after the first delivery
+  if (!config.spill_path.empty()) {
+    has_spill = std::ifstream{config.spill_path}.good() ||
+                std::ifstream{config.spill_path + SPILL_REPLAY_SUFFIX}.good();
+  }
+
+  current = take_spare_buffer();
+  writer = std::thread{&InfluxSink::run_writer, this};
+}
+
+
+InfluxSink::~InfluxSink() {
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    stopping = true;
+  }
+  wakeup.notify_one();
+
+  if (writer.joinable()) {
+    writer.join();
+  }
+}
+
+
+void InfluxSink::push(const std::chrono::milliseconds timestamp, const NVMLDevice::info_t& info) {
+  push_sample(timestamp, info);
+}
+
+
+void InfluxSink::push(const std::chrono::milliseconds timestamp, const ProcessOverheadMeter::overhead_t& overhead) {
+  push_sample(timestamp, overhead);
+}
+
+
+template<typename sample_t>
+void InfluxSink::push_sample(const std::chrono::milliseconds timestamp, const sample_t& sample) {
+  std::lock_guard<std::mutex> lock{mutex};
+
+  if (current.empty()) {
+    current_started_at = batch_clock_t::now();
+  }
+
+  encode_influx_line(current, timestamp, sample);
+
+  if (current.size() >= config.batch_size) {
+    seal_current_batch();
+    wakeup.notify_one();
+  }
+}
+
+
+// must be called with mutex locked
+void InfluxSink::seal_current_batch() {
+  pending_size += current.size();
+  pending.push_back(std::move(current));
+  current = take_spare_buffer();
+}
+
+
+// must be called with mutex locked
+std::string InfluxSink::take_spare_buffer() {
+  if (!spare.empty()) {
+    auto buffer = std::move(spare.back());
+    spare.pop_back();
+    return buffer;
+  }
+
+  std::string buffer;
+  // the last line of a batch overshoots the size threshold
+  buffer.reserve(config.batch_size + config.batch_size / 4);
+  return buffer;
+}
+
+
+// must be called with mutex locked
+void InfluxSink::recycle_buffer(std::string&& buffer) {
+  if (spare.size() < INFLUX_MAX_SPARE_BUFFERS) {
+    buffer.clear();
+    spare.push_back(std::move(buffer));
+  }
+}
+
+
+void InfluxSink::run_writer() {
+  std::unique_lock<std::mutex> lock{mutex};
+
+  while (true) {
+    const auto has_work = [this] { return stopping || !pending.empty(); };
+
+    if (current.empty()) {
+      wakeup.wait_for(lock, config.batch_period, has_work);
+    } else {
+      wakeup.wait_until(lock, current_started_at + config.batch_period, has_work);
+    }
+
+    if (
+      !current.empty() &&
+      (stopping || batch_clock_t::now() - current_started_at >= config.batch_period)
+    ) {
+      seal_current_batch();
+    }
+
+    if (pending.empty()) {
+      if (stopping) {
+        break;
+      }
+      continue;
+    }
+
+    // delivery may take up to network timeout, meanwhile memory limit holds
+    lock.unlock();
+    maybe_spill_overflow(config.max_pending_size);
+    lock.lock();
+
+    if (pending.empty()) {
+      continue;
+    }
+
+    auto batch = std::move(pending.front());
+    pending.pop_front();
+    pending_size -= batch.size();
+
+    lock.unlock();
+    const auto result = deliver(batch);
+
+    if (result == delivery_t::DELIVERED) {
+      retry_backoff = config.retry_backoff;
+      maybe_replay_spill();
+    }
+    lock.lock();
+
+    if (result != delivery_t::FAILED) {
+      recycle_buffer(std::move(batch));
+      continue;
+    }
+
+    // keep undelivered batch first in line
+    pending_size += batch.size();
+    pending.push_front(std::move(batch));
+
+    if (stopping) {
+      // nothing is going to retry it, so keep what fits the disk
+      lock.unlock();
+      maybe_spill_overflow(0);
+      break;
+    }
+
+    wakeup.wait_for(lock, retry_backoff, [this] { return stopping; });
+    retry_backoff = std::min(retry_backoff * 2, config.max_retry_backoff);
+
+    lock.unlock();
+    maybe_spill_overflow(config.max_pending_size);
+    lock.lock();
+  }
+}
+
+
+InfluxSink::delivery_t InfluxSink::deliver(std::string_view batch) {
+  std::string_view body{batch};
+
+#ifdef HAVE_ZLIB
+  if (config.compress) {
+    if (!maybe_gzip(batch, compressed)) {
+      std::cerr << "failed to compress InfluxDB batch of " << batch.size() << " bytes" << std::endl;
+      maybe_spill(batch);
+      return delivery_t::REJECTED;
+    }
+    body = compressed;
+  }
+#endif
+
+  const auto status = connection.maybe_post(config.path, headers, body);
+
+  if (status.has_value() && status.value() >= 200 && status.value() < 300) {
+    if (failing) {
+      std::cerr << "InfluxDB is reachable again" << std::endl;
+      failing = false;
+    }
+    return delivery_t::DELIVERED;
+  }
+
+  // only malformed or oversized data is not worth retrying; authorization,
+  // missing bucket, throttling and server errors may be fixed meanwhile
+  if (
+    status.has_value() &&
+    (status.value() == 400 || status.value() == 413 || status.value() == 422)
+  ) {
+    std::cerr << "InfluxDB rejected batch of " << batch.size() << " bytes"
+              << " with status " << status.value() << std::endl;
+    return delivery_t::REJECTED;
+  }
+
+  if (!failing) {
+    std::cerr << "failed to deliver InfluxDB batch: "
+              << (status.has_value() ? "status " + std::to_string(status.value()) : std::string("network error"))
+              << "; retrying" << std::endl;
+    failing = true;
+  }
+  return delivery_t::FAILED;
+}
+
+
+void InfluxSink::maybe_spill(std::string_view batch) {
+  if (config.spill_path.empty()) {
+    std::cerr << "dropped InfluxDB batch of " << batch.size() << " bytes" << std::endl;
+    return;
+  }
+
+  std::ofstream spill{config.spill_path, std::ios::binary | std::ios::app};
+  spill.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+
+  if (!spill.good()) {
+    std::cerr << "failed to spill InfluxDB batch of " << batch.size() << " bytes"
+              << " to '" << config.spill_path << "'" << std::endl;
+    return;
+  }
+
+  has_spill = true;
+}
+
+
+void InfluxSink::maybe_spill_overflow(const size_t max_pending_size) {
+  std::vector<std::string> overflow;
+
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    while (pending_size > max_pending_size && !pending.empty()) {
+      pending_size -= pending.front().size();
+      overflow.push_back(std::move(pending.front()));
+      pending.pop_front();
+    }
+  }
+
+  for (auto& batch : overflow) {
+    maybe_spill(batch);
+  }
+
+  if (!overflow.empty()) {
+    std::lock_guard<std::mutex> lock{mutex};
+    for (auto& batch : overflow) {
+      recycle_buffer(std::move(batch));
+    }
+  }
+}
+
+
+void InfluxSink::maybe_replay_spill() {
+  if (!has_spill) {
+    return;
+  }
+
+  // replay from a separate file, so batches failing again can be spilled anew
+  const auto replay_path = config.spill_path + SPILL_REPLAY_SUFFIX;
+
+  if (!std::ifstream{replay_path}.good()) {
+    if (std::rename(config.spill_path.c_str(), replay_path.c_str()) != 0) {
+      return;
+    }
+  }
+  has_spill = false;
+
+  std::ifstream replay{replay_path, std::ios::binary};
+  std::string batch = [this] {
+    std::lock_guard<std::mutex> lock{mutex};
+    return take_spare_buffer();
+  }();
+  std::string line;
+  bool failed{false};
+
+  const auto flush = [&] {
+    if (batch.empty()) {
+      return;
+    }
+    if (failed || deliver(batch) == delivery_t::FAILED) {
+      failed = true;
+      maybe_spill(batch);
+    }
+    batch.clear();
+    maybe_spill_overflow(config.max_pending_size);
+  };
+
+  while (std::getline(replay, line)) {
+    batch.append(line).push_back('\n');
+    if (batch.size() >= config.batch_size) {
+      flush();
+    }
+  }
+  flush();
+
+  replay.close();
+  std::remove(replay_path.c_str());
+
+  has_spill = std::ifstream{config.spill_path}.good();
+
+  std::lock_guard<std::mutex> lock{mutex};
+  recycle_buffer(std::move(batch));
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#ifndef _NVIDIA_GPU_MONITOR_INFLUX_H
+#define _NVIDIA_GPU_MONITOR_INFLUX_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "config.h"
+#include "http.h"
+#include "nvml.h"
+#include "overhead.h"
+
+
+constexpr auto INFLUX_MEASUREMENT{"nvidia_gpu"};
+constexpr auto INFLUX_OVERHEAD_MEASUREMENT{"nvidia_gpu_monitor"};
+
+constexpr size_t INFLUX_DEFAULT_BATCH_SIZE{64 * 1024};                  // in bytes
+constexpr size_t INFLUX_MAX_BATCH_SIZE{64 * 1024 * 1024};               // in bytes
+constexpr auto INFLUX_DEFAULT_BATCH_PERIOD{std::chrono::milliseconds(1000)};
+constexpr auto INFLUX_DEFAULT_RETRY_BACKOFF{std::chrono::milliseconds(250)}; // doubled on each retry
+constexpr auto INFLUX_DEFAULT_MAX_RETRY_BACKOFF{std::chrono::milliseconds(30000)};
+constexpr auto INFLUX_DEFAULT_TIMEOUT{std::chrono::milliseconds(5000)};
+constexpr size_t INFLUX_DEFAULT_MAX_PENDING_SIZE{16 * 1024 * 1024};     // in bytes
+
+constexpr size_t INFLUX_MAX_SPARE_BUFFERS{8};
+
+
+// Appends a sample of a device to a buffer in InfluxDB line protocol.
+void encode_influx_line(
+  std::string& buffer,
+  const std::chrono::milliseconds timestamp,
+  const NVMLDevice::info_t& info
+);
+
+// Appends resources consumed by the monitor to a buffer in InfluxDB line protocol.
+void encode_influx_line(
+  std::string& buffer,
+  const std::chrono::milliseconds timestamp,
+  const ProcessOverheadMeter::overhead_t& overhead
+);
+
+
+// Pushes samples to InfluxDB over HTTP.
+//
+// Samples are encoded into a batch buffer by the polling thread and handed
+// over to a writer thread once the batch grows past the configured size or
+// age. Only the writer thread touches the network and the disk. A batch which
+// could not be delivered stays first in line and is retried with growing
+// backoff. Only batches piling up in memory past the configured limit are
+// appended to a spill file, which is replayed after the next successful
+// delivery, or dropped if no spill file is configured.
+class InfluxSink {
+  public:
+    typedef struct config_st {
+      std::string host;
+      unsigned short port;
+      std::string path;  // e.g. "/api/v2/write?org=o&bucket=b" or "/write?db=d"
+      std::string token; // optional
+
+      size_t batch_size{INFLUX_DEFAULT_BATCH_SIZE};
+      std::chrono::milliseconds batch_period{INFLUX_DEFAULT_BATCH_PERIOD};
+      bool compress{false};
+
+      std::chrono::milliseconds retry_backoff{INFLUX_DEFAULT_RETRY_BACKOFF};
+      std::chrono::milliseconds max_retry_backoff{INFLUX_DEFAULT_MAX_RETRY_BACKOFF};
+      std::chrono::milliseconds timeout{INFLUX_DEFAULT_TIMEOUT};
+
+      size_t max_pending_size{INFLUX_DEFAULT_MAX_PENDING_SIZE};
+      std::string spill_path; // optional, overflow is dropped if empty
+    } config_t;
+
+    InfluxSink(const config_t& config);
+    ~InfluxSink();
+
+    InfluxSink(const InfluxSink&) = delete;
+    InfluxSink& operator=(const InfluxSink&) = delete;
+
+    // Never waits for network or disk.
+    void push(const std::chrono::milliseconds timestamp, const NVMLDevice::info_t& info);
+    void push(const std::chrono::milliseconds timestamp, const ProcessOverheadMeter::overhead_t& overhead);
+
+  private:
+    typedef std::chrono::steady_clock batch_clock_t;
+
+    enum class delivery_t {
+      DELIVERED,
+      REJECTED,
+      FAILED,
+    };
+
+    template<typename sample_t>
+    void push_sample(const std::chrono::milliseconds timestamp, const sample_t& sample);
+
+    void run_writer();
+    void seal_current_batch();
+    std::string take_spare_buffer();
+    void recycle_buffer(std::string&& buffer);
+
+    delivery_t deliver(std::string_view batch);
+    void maybe_spill(std::string_view batch);
+    void maybe_spill_overflow(const size_t max_pending_size);
+    void maybe_replay_spill();
+
+    const config_t config;
+    std::string headers;
+
+    // shared between polling and writer threads
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping{false};
+    std::string current;
+    batch_clock_t::time_point current_started_at;
+    std::deque<std::string> pending;
+    size_t pending_size{0};
+    std::vector<std::string> spare;
+
+    // owned by writer thread
+    HTTPConnection connection;
+    std::string compressed;
+    std::chrono::milliseconds retry_backoff;
+    bool failing{false};
+    bool has_spill{false};
+
+    std::thread writer;
+};
+
+
+#endif // _NVIDIA_GPU_MONITOR_INFLUX_H
\ No newline at end of file
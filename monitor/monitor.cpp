@@ -1,10 +1,44 @@
 #include "monitor.h"
 
 
-constexpr auto POLLING_PERIOD{std::chrono::milliseconds(250)};
+constexpr auto PLACEMENT_REFRESH_PERIOD{std::chrono::seconds(10)};
 
 
-int main() {
+volatile std::sig_atomic_t stop_requested{0};
+
+
+void request_stop(int) {
+  stop_requested = 1;
+}
+
+
+std::string_view energy_source_name(const NVMLDevice::energy_source_t source) {
+  switch (source) {
+    case NVMLDevice::energy_source_t::COUNTER:
+      return "counter";
+    case NVMLDevice::energy_source_t::INTEGRATED:
+      return "integrated";
+  }
+  return "unknown";
+}
+
+
+void report_overhead(const ProcessOverheadMeter::overhead_t& overhead) {
+  std::cerr << "overhead:"
+            << " interval="                     << overhead.interval.count()          << "ms"
+            << " user_time="                    << overhead.user_time.count()         << "us"
+            << " system_time="                  << overhead.system_time.count()       << "us"
+            << " cpu="                          << overhead.cpu_percent               << "%"
+            << " voluntary_context_switches="   << overhead.voluntary_context_switches
+            << " involuntary_context_switches=" << overhead.involuntary_context_switches
+            << " rss="                          << overhead.rss                       << "kB"
+            << std::endl;
+}
+
+
+int main(int argc, char* argv[]) {
+  const auto options = parse_options_or_halt(argc, argv);
+
   NVML nvml;
 
   auto nvml_info = nvml.get_info();
@@ -29,18 +63,36 @@ int main() {
               << "  temperature:"        << "\t\t"   << info.metrics.temperature        << "C"  << "\n"
               << "  power_usage:"        << "\t\t"   << info.metrics.power_usage        << "mW" << "\n"
               << "  gpu_utilization:"    << "\t"     << info.metrics.gpu_utilization    << "%"  << "\n"
-              << "  memory_utilization:" << "\t"     << info.metrics.memory_utilization << "%"  << "\n";
+              << "  memory_utilization:" << "\t"     << info.metrics.memory_utilization << "%"  << "\n"
+              << "  energy_source:"      << "\t\t"   << energy_source_name(info.energy_source)  << "\n";
+  }
+
+  // writer thread of the sink inherits placement of the polling thread
+  ThreadPlacement placement{options.placement};
+  placement.apply_or_halt(device_manager);
+
+  std::unique_ptr<InfluxSink> influx;
+  if (options.influx.has_value()) {
+    influx = std::make_unique<InfluxSink>(options.influx.value());
   }
 
   std::cout << "\n\n"
-            << "Monitoring GPUs with polling period of " << POLLING_PERIOD.count() << "ms"
+            << "Monitoring GPUs with polling period of " << options.polling_period.count() << "ms"
             << "\n\n\n"
-            << "timestamp_ms,index,fan_speed,temperature,power_usage,gpu_utilization,memory_utilization"
+            << "timestamp_ms,index,fan_speed,temperature,power_usage,gpu_utilization,memory_utilization,total_energy_mj,energy_delta_mj"
             << "\n";
 
   std::chrono::milliseconds timestamp;
 
-  while (true) {
+  ProcessOverheadMeter overhead_meter;
+  auto overhead_reported_at = std::chrono::steady_clock::now();
+  auto placement_refreshed_at = std::chrono::steady_clock::now();
+
+  // leaving the loop lets the sink deliver or spill pending batches
+  std::signal(SIGINT, request_stop);
+  std::signal(SIGTERM, request_stop);
+
+  while (!stop_requested) {
     timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
       std::chrono::high_resolution_clock::now().time_since_epoch()
       );
@@ -56,9 +108,37 @@ int main() {
         << info.metrics.temperature        << ","
         << info.metrics.power_usage        << ","
         << info.metrics.gpu_utilization    << ","
-        << info.metrics.memory_utilization << std::endl;
+        << info.metrics.memory_utilization << ","
+        << info.metrics.total_energy       << ","
+        << info.metrics.energy_delta       << std::endl;
+
+      if (influx) {
+        influx->push(timestamp, info);
+      }
     }
 
-    std::this_thread::sleep_for(POLLING_PERIOD);
+    const auto now = std::chrono::steady_clock::now();
+
+    if (
+      options.overhead_report_period.count() > 0 &&
+      now - overhead_reported_at >= options.overhead_report_period
+    ) {
+      const auto overhead = overhead_meter.measure_or_halt();
+      report_overhead(overhead);
+
+      if (influx) {
+        influx->push(timestamp, overhead);
+      }
+      overhead_reported_at = now;
+    }
+
+    if (now - placement_refreshed_at >= PLACEMENT_REFRESH_PERIOD) {
+      placement.apply_or_halt(device_manager);
+      placement_refreshed_at = now;
+    }
+
+    std::this_thread::sleep_for(options.polling_period);
   }
+
+  return 0;
 }
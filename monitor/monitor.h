@@ -2,10 +2,16 @@
 #define _NVIDIA_GPU_MONITOR_H
 
 #include <chrono>
+#include <csignal>
 #include <iostream>
+#include <memory>
 #include <thread>
 
+#include "influx.h"
 #include "nvml.h"
+#include "options.h"
+#include "overhead.h"
+#include "placement.h"
 #include "utils.h"
 
 #endif // _NVIDIA_GPU_MONITOR_H
\ No newline at end of file
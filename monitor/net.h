@@ -0,0 +1,32 @@
+#ifndef _NVIDIA_GPU_MONITOR_NET_H
+#define _NVIDIA_GPU_MONITOR_NET_H
+
+#include <chrono>
+#include <string_view>
+
+#include "config.h"
+
+
+#ifdef HAVE_WINDOWS_H
+  #include "net_windows.h"
+#elif HAVE_SYS_SOCKET_H
+  #include "net_unix.h"
+#else
+  #error Unsupported target platform: neither <windows.h> nor <sys/socket.h> are present
+#endif
+
+
+// Network failures are expected and recoverable, hence none of the functions
+// below halt: callers decide whether to retry, reconnect or give up.
+
+void init_net_or_halt();
+socket_handle_t maybe_connect_socket(
+  std::string_view host,
+  const unsigned short port,
+  const std::chrono::milliseconds timeout
+);
+bool send_all(socket_handle_t socket, const char* data, size_t size);
+long receive_some(socket_handle_t socket, char* buffer, size_t size);
+void close_socket(socket_handle_t socket);
+
+#endif // _NVIDIA_GPU_MONITOR_NET_H
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include <string>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "net.h"
+
+
+#ifdef MSG_NOSIGNAL
+  constexpr int SEND_FLAGS{MSG_NOSIGNAL};
+#else
+  constexpr int SEND_FLAGS{0};
+#endif
+
+
+void init_net_or_halt() {
+}
+
+
+socket_handle_t maybe_connect_socket(
+  std::string_view host,
+  const unsigned short port,
+  const std::chrono::milliseconds timeout
+) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  addrinfo* addresses{NULL};
+  if (getaddrinfo(std::string(host).c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+    return INVALID_SOCKET_HANDLE;
+  }
+
+  timeval tv{};
+  tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+  tv.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+
+  socket_handle_t handle{INVALID_SOCKET_HANDLE};
+
+  for (auto address = addresses; address != NULL; address = address->ai_next) {
+    handle = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (handle == INVALID_SOCKET_HANDLE) {
+      continue;
+    }
+
+    // on Linux SO_SNDTIMEO bounds connect() as well
+    setsockopt(handle, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    setsockopt(handle, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    const int enabled{1};
+    setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+    setsockopt(handle, SOL_SOCKET, SO_KEEPALIVE, &enabled, sizeof(enabled));
+
+    if (connect(handle, address->ai_addr, address->ai_addrlen) == 0) {
+      break;
+    }
+
+    close(handle);
+    handle = INVALID_SOCKET_HANDLE;
+  }
+
+  freeaddrinfo(addresses);
+  return handle;
+}
+
+
+bool send_all(socket_handle_t socket, const char* data, size_t size) {
+  while (size > 0) {
+    const auto sent = send(socket, data, size, SEND_FLAGS);
+    if (sent <= 0) {
+      return false;
+    }
+    data += sent;
+    size -= static_cast<size_t>(sent);
+  }
+  return true;
+}
+
+
+long receive_some(socket_handle_t socket, char* buffer, size_t size) {
+  return static_cast<long>(recv(socket, buffer, size, 0));
+}
+
+
+void close_socket(socket_handle_t socket) {
+  close(socket);
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#ifndef _NVIDIA_GPU_MONITOR_NET_UNIX_H
+#define _NVIDIA_GPU_MONITOR_NET_UNIX_H
+
+#include <sys/socket.h>
+
+typedef int socket_handle_t;
+
+constexpr socket_handle_t INVALID_SOCKET_HANDLE{-1};
+
+
+#endif // _NVIDIA_GPU_MONITOR_NET_UNIX_H
\ No newline at end of file
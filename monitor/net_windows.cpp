@@ -0,0 +1,79 @@
+#include <string>
+
+#include "net.h"
+#include "utils.h"
+
+
+void init_net_or_halt() {
+  WSADATA data;
+
+  if (auto status = WSAStartup(MAKEWORD(2, 2), &data); status != 0) {
+    halt("failed to init Winsock: error " + std::to_string(status));
+  }
+}
+
+
+socket_handle_t maybe_connect_socket(
+  std::string_view host,
+  const unsigned short port,
+  const std::chrono::milliseconds timeout
+) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  addrinfo* addresses{NULL};
+  if (getaddrinfo(std::string(host).c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+    return INVALID_SOCKET_HANDLE;
+  }
+
+  const DWORD timeout_ms{static_cast<DWORD>(timeout.count())};
+  socket_handle_t handle{INVALID_SOCKET_HANDLE};
+
+  for (auto address = addresses; address != NULL; address = address->ai_next) {
+    handle = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (handle == INVALID_SOCKET_HANDLE) {
+      continue;
+    }
+
+    setsockopt(handle, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout_ms), sizeof(timeout_ms));
+    setsockopt(handle, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout_ms), sizeof(timeout_ms));
+
+    const BOOL enabled{TRUE};
+    setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&enabled), sizeof(enabled));
+    setsockopt(handle, SOL_SOCKET, SO_KEEPALIVE, reinterpret_cast<const char*>(&enabled), sizeof(enabled));
+
+    if (connect(handle, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0) {
+      break;
+    }
+
+    closesocket(handle);
+    handle = INVALID_SOCKET_HANDLE;
+  }
+
+  freeaddrinfo(addresses);
+  return handle;
+}
+
+
+bool send_all(socket_handle_t socket, const char* data, size_t size) {
+  while (size > 0) {
+    const auto sent = send(socket, data, static_cast<int>(size), 0);
+    if (sent <= 0) {
+      return false;
+    }
+    data += sent;
+    size -= static_cast<size_t>(sent);
+  }
+  return true;
+}
+
+
+long receive_some(socket_handle_t socket, char* buffer, size_t size) {
+  return recv(socket, buffer, static_cast<int>(size), 0);
+}
+
+
+void close_socket(socket_handle_t socket) {
+  closesocket(socket);
+}
\ No newline at end of file
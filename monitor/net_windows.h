@@ -0,0 +1,11 @@
+#ifndef _NVIDIA_GPU_MONITOR_NET_WINDOWS_H
+#define _NVIDIA_GPU_MONITOR_NET_WINDOWS_H
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+typedef SOCKET socket_handle_t;
+
+constexpr socket_handle_t INVALID_SOCKET_HANDLE{INVALID_SOCKET};
+
+#endif // _NVIDIA_GPU_MONITOR_NET_WINDOWS_H
\ No newline at end of file
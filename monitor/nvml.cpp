@@ -30,6 +30,9 @@ void NVML::bind_functions_or_halt() {
   nvmlDeviceGetTemperature      = reinterpret_cast<nvmlDeviceGetTemperature_t     >(load_dfunc_or_halt(lib, "nvmlDeviceGetTemperature"));
   nvmlDeviceGetPowerUsage       = reinterpret_cast<nvmlDeviceGetPowerUsage_t      >(load_dfunc_or_halt(lib, "nvmlDeviceGetPowerUsage"));
   nvmlDeviceGetUtilizationRates = reinterpret_cast<nvmlDeviceGetUtilizationRates_t>(load_dfunc_or_halt(lib, "nvmlDeviceGetUtilizationRates"));
+
+  nvmlDeviceGetTotalEnergyConsumption = reinterpret_cast<nvmlDeviceGetTotalEnergyConsumption_t>(maybe_load_dfunc(lib, "nvmlDeviceGetTotalEnergyConsumption"));
+  nvmlDeviceGetComputeRunningProcesses = reinterpret_cast<nvmlDeviceGetComputeRunningProcesses_t>(maybe_load_dfunc(lib, "nvmlDeviceGetComputeRunningProcesses"));
 }
 
 
@@ -212,6 +215,67 @@ void NVML::get_device_utilization_rates_or_halt(const unsigned int index, const
 }
 
 
+std::optional<unsigned long long> NVML::maybe_get_device_total_energy_consumption_or_halt(const unsigned int index, const nvmlDevice_t& handle) const {
+  if (nvmlDeviceGetTotalEnergyConsumption == NULL) {
+    return std::nullopt;
+  }
+
+  unsigned long long value;
+  auto nv_status = nvmlDeviceGetTotalEnergyConsumption(handle, &value);
+
+  if (nv_status == nvmlReturn_t::NVML_ERROR_NOT_SUPPORTED) {
+    return std::nullopt;
+  }
+
+  if (nv_status != nvmlReturn_t::NVML_SUCCESS) {
+    halt(
+      "failed to get total energy consumption for device #" + std::to_string(index) +
+      ": " + std::string(nvmlErrorString(nv_status))
+    );
+  }
+
+  return value;
+}
+
+
+std::vector<unsigned int> NVML::get_device_compute_process_ids_or_halt(const unsigned int index, const nvmlDevice_t& handle) const {
+  if (nvmlDeviceGetComputeRunningProcesses == NULL) {
+    return {};
+  }
+
+  std::vector<nvmlProcessInfo_t> infos;
+  unsigned int count{0};
+  nvmlReturn_t nv_status;
+
+  // process list may grow between querying its size and fetching it
+  do {
+    infos.resize(count);
+    nv_status = nvmlDeviceGetComputeRunningProcesses(handle, &count, infos.data());
+  } while (nv_status == nvmlReturn_t::NVML_ERROR_INSUFFICIENT_SIZE);
+
+  if (
+    nv_status == nvmlReturn_t::NVML_ERROR_NOT_SUPPORTED ||
+    nv_status == nvmlReturn_t::NVML_ERROR_NO_PERMISSION
+  ) {
+    return {};
+  }
+
+  if (nv_status != nvmlReturn_t::NVML_SUCCESS) {
+    halt(
+      "failed to get compute processes for device #" + std::to_string(index) +
+      ": " + std::string(nvmlErrorString(nv_status))
+    );
+  }
+
+  std::vector<unsigned int> pids;
+  for (unsigned int i{0}; i < count; ++i) {
+    pids.push_back(infos[i].pid);
+  }
+
+  return pids;
+}
+
+
 NVML::info_t NVML::get_info() const {
   return NVML::info_t{
     driver_version,
@@ -229,28 +293,133 @@ NVMLDevice::NVMLDevice(
    api{api}
 {
   name = api.get_device_name_or_halt(index, handle);
+  init_energy_or_halt();
   refresh_metrics_or_halt();
 }
 
 
+void NVMLDevice::init_energy_or_halt() {
+  energy_sampled_at = energy_clock_t::now();
+
+  if (
+    auto value = api.maybe_get_device_total_energy_consumption_or_halt(index, handle);
+    value.has_value()
+  ) {
+    energy_source = energy_source_t::COUNTER;
+    energy_counter = value.value();
+  } else {
+    energy_source = energy_source_t::INTEGRATED;
+    power_usage = api.get_device_power_usage_or_halt(index, handle);
+  }
+}
+
+
 void NVMLDevice::refresh_metrics_or_halt() {
   fan_speed = api.get_device_fan_speed_or_halt(index, handle);
   temperature = api.get_device_temperature_or_halt(index, handle);
-  power_usage = api.get_device_power_usage_or_halt(index, handle);
+  refresh_energy_or_halt();
   api.get_device_utilization_rates_or_halt(index, handle, utilization);
 }
 
 
+// mW * us = nJ
+static unsigned long long integrate_energy_uj(
+  const unsigned int previous_power_usage,
+  const unsigned int power_usage,
+  const std::chrono::microseconds elapsed
+) {
+  const auto average_power_usage = (
+    static_cast<unsigned long long>(previous_power_usage) + power_usage
+  ) / 2;
+  return average_power_usage * static_cast<unsigned long long>(elapsed.count()) / 1000;
+}
+
+
+unsigned long long NVMLDevice::read_total_energy_or_halt() const {
+  if (energy_source == energy_source_t::COUNTER) {
+    const auto counter = read_energy_counter_or_halt();
+    return total_energy_uj / 1000 + get_energy_counter_increment(counter);
+  }
+
+  const auto current_power_usage = api.get_device_power_usage_or_halt(index, handle);
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+    energy_clock_t::now() - energy_sampled_at
+  );
+
+  return (total_energy_uj + integrate_energy_uj(power_usage, current_power_usage, elapsed)) / 1000;
+}
+
+
+void NVMLDevice::refresh_energy_or_halt() {
+  if (energy_source == energy_source_t::COUNTER) {
+    refresh_energy_from_counter_or_halt();
+  } else {
+    refresh_energy_by_integration_or_halt();
+  }
+}
+
+
+unsigned long long NVMLDevice::read_energy_counter_or_halt() const {
+  const auto value = api.maybe_get_device_total_energy_consumption_or_halt(index, handle);
+  if (!value.has_value()) {
+    halt("energy counter of device #" + std::to_string(index) + " became unavailable");
+  }
+
+  return value.value();
+}
+
+
+// in millijoules
+unsigned long long NVMLDevice::get_energy_counter_increment(const unsigned long long counter) const {
+  // counter restarts from zero on driver reload
+  return counter >= energy_counter ? counter - energy_counter : counter;
+}
+
+
+void NVMLDevice::refresh_energy_from_counter_or_halt() {
+  power_usage = api.get_device_power_usage_or_halt(index, handle);
+
+  const auto counter = read_energy_counter_or_halt();
+  energy_delta_uj = get_energy_counter_increment(counter) * 1000;
+  total_energy_uj += energy_delta_uj;
+  energy_counter = counter;
+}
+
+
+void NVMLDevice::refresh_energy_by_integration_or_halt() {
+  const auto previous_power_usage = power_usage;
+  const auto previous_sampled_at = energy_sampled_at;
+
+  power_usage = api.get_device_power_usage_or_halt(index, handle);
+  energy_sampled_at = energy_clock_t::now();
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+    energy_sampled_at - previous_sampled_at
+  );
+
+  energy_delta_uj = integrate_energy_uj(previous_power_usage, power_usage, elapsed);
+  total_energy_uj += energy_delta_uj;
+}
+
+
+std::vector<unsigned int> NVMLDevice::get_compute_process_ids_or_halt() const {
+  return api.get_device_compute_process_ids_or_halt(index, handle);
+}
+
+
 NVMLDevice::info_t NVMLDevice::get_info() const {
   return NVMLDevice::info_t{
     name,
     index,
+    energy_source,
     NVMLDevice::metrics_t{
       fan_speed,
       temperature,
       power_usage,
       utilization.gpu,
       utilization.memory,
+      total_energy_uj / 1000,
+      energy_delta_uj / 1000,
     }
   };
 }
@@ -1,6 +1,8 @@
 #ifndef _NVIDIA_GPU_MONITOR_NVML_H
 #define _NVIDIA_GPU_MONITOR_NVML_H
 
+#include <chrono>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <string_view>
@@ -65,6 +67,11 @@ typedef struct nvmlUtilization_st {
   unsigned int memory;
 } nvmlUtilization_t;
 
+typedef struct nvmlProcessInfo_st {
+  unsigned int pid;
+  unsigned long long usedGpuMemory;
+} nvmlProcessInfo_t;
+
 
 typedef nvmlReturn_t (*nvmlInit_t)(void);
 typedef nvmlReturn_t (*nvmlShutdown_t)(void);
@@ -79,6 +86,8 @@ typedef nvmlReturn_t (*nvmlDeviceGetFanSpeed_t)(nvmlDevice_t device, unsigned in
 typedef nvmlReturn_t (*nvmlDeviceGetTemperature_t)(nvmlDevice_t device, nvmlTemperatureSensors_t sensorType, unsigned int* temp);
 typedef nvmlReturn_t (*nvmlDeviceGetPowerUsage_t)(nvmlDevice_t device, unsigned int* power);
 typedef nvmlReturn_t (*nvmlDeviceGetUtilizationRates_t)(nvmlDevice_t device, nvmlUtilization_t* utilization);
+typedef nvmlReturn_t (*nvmlDeviceGetTotalEnergyConsumption_t)(nvmlDevice_t device, unsigned long long* energy);
+typedef nvmlReturn_t (*nvmlDeviceGetComputeRunningProcesses_t)(nvmlDevice_t device, unsigned int* infoCount, nvmlProcessInfo_t* infos);
 
 
 class NVML {
@@ -98,6 +107,8 @@ class NVML {
     unsigned int get_device_temperature_or_halt(const unsigned int index, const nvmlDevice_t& handle) const;
     unsigned int get_device_power_usage_or_halt(const unsigned int index, const nvmlDevice_t& handle) const;
     void get_device_utilization_rates_or_halt(const unsigned int index, const nvmlDevice_t& handle, nvmlUtilization_t& utilization) const;
+    std::optional<unsigned long long> maybe_get_device_total_energy_consumption_or_halt(const unsigned int index, const nvmlDevice_t& handle) const;
+    std::vector<unsigned int> get_device_compute_process_ids_or_halt(const unsigned int index, const nvmlDevice_t& handle) const;
     info_t get_info() const;
 
   private:    
@@ -128,22 +139,36 @@ class NVML {
     nvmlDeviceGetTemperature_t nvmlDeviceGetTemperature{NULL};
     nvmlDeviceGetPowerUsage_t nvmlDeviceGetPowerUsage{NULL};
     nvmlDeviceGetUtilizationRates_t nvmlDeviceGetUtilizationRates{NULL};
+
+    // optional: absent from drivers older than R390
+    nvmlDeviceGetTotalEnergyConsumption_t nvmlDeviceGetTotalEnergyConsumption{NULL};
+
+    // optional: needed only to avoid CPUs of GPU jobs
+    nvmlDeviceGetComputeRunningProcesses_t nvmlDeviceGetComputeRunningProcesses{NULL};
 };
 
 
 class NVMLDevice {
   public:
+    enum class energy_source_t {
+      COUNTER,    // nvmlDeviceGetTotalEnergyConsumption
+      INTEGRATED, // trapezoidal integration of power usage samples
+    };
+
     typedef struct metrics_st {
       const unsigned int fan_speed;
       const unsigned int temperature;
       const unsigned int power_usage;
       const unsigned int gpu_utilization;
       const unsigned int memory_utilization;
+      const unsigned long long total_energy;
+      const unsigned long long energy_delta;
     } metrics_t;
 
     typedef struct info_st {
       std::string_view name;
       const unsigned int index;
+      const energy_source_t energy_source;
       const metrics_st metrics;      
 
     } info_t;
@@ -158,7 +183,31 @@ class NVMLDevice {
     void refresh_metrics_or_halt();
     info_t get_info() const;
 
+    // Cheap reading of energy consumed since device detection, in millijoules.
+    // Takes a single sample without refreshing metrics or affecting energy
+    // delta reported by them, so it can be used to bracket a job with
+    // start/stop readings. Not synchronized: call it from the thread which
+    // refreshes metrics.
+    //
+    // With energy counter the reading is exact. With integration it is an
+    // estimate extrapolated from the current power usage, while the next
+    // refresh integrates its own sample, so a reading may exceed
+    // metrics.total_energy reported afterwards; bill either by readings or by
+    // reported totals, not by a mix of both.
+    unsigned long long read_total_energy_or_halt() const;
+
+    std::vector<unsigned int> get_compute_process_ids_or_halt() const;
+
   private:    
+    typedef std::chrono::steady_clock energy_clock_t;
+
+    void init_energy_or_halt();
+    void refresh_energy_or_halt();
+    void refresh_energy_from_counter_or_halt();
+    void refresh_energy_by_integration_or_halt();
+    unsigned long long read_energy_counter_or_halt() const;
+    unsigned long long get_energy_counter_increment(const unsigned long long counter) const;
+
     const unsigned int index;
     const nvmlDevice_t handle;
     const NVML& api;
@@ -170,6 +219,12 @@ class NVMLDevice {
     unsigned int power_usage{0}; // in milliwatts
 
     nvmlUtilization_t utilization{0, 0};
+
+    energy_source_t energy_source{energy_source_t::INTEGRATED};
+    unsigned long long energy_counter{0};        // in millijoules, driver counter at previous sample
+    unsigned long long total_energy_uj{0};       // in microjoules, since detection
+    unsigned long long energy_delta_uj{0};       // in microjoules, since previous sample
+    energy_clock_t::time_point energy_sampled_at;
 };
 
 
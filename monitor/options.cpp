@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "options.h"
+#include "utils.h"
+
+
+constexpr std::string_view HTTP_SCHEME{"http://"};
+constexpr unsigned short HTTP_DEFAULT_PORT{80};
+
+constexpr auto USAGE{
+  "usage: monitor [options]\n"
+  "\n"
+  "options:\n"
+  "  --polling-period-ms=N          period of polling devices (default: 250)\n"
+  "  --overhead-report-ms=N         period of reporting resources consumed by\n"
+  "                                 monitor itself, 0 to disable (default: 10000)\n"
+  "  --cpus=LIST                    CPUs to run monitor threads on, e.g. 0-3,8\n"
+  "                                 (default: inherited)\n"
+  "  --avoid-gpu-job-cpus           keep monitor threads off CPUs allowed for\n"
+  "                                 processes running on GPUs\n"
+  "  --sched-policy=POLICY          scheduling policy of monitor threads:\n"
+  "                                 other, batch, idle, fifo or rr\n"
+  "  --sched-priority=N             priority for fifo and rr policies, 1..99\n"
+  "  --influx-url=URL               push samples to InfluxDB write endpoint, e.g.\n"
+  "                                 http://localhost:8086/api/v2/write?org=o&bucket=b\n"
+  "  --influx-token=TOKEN           token for InfluxDB authorization\n"
+  "  --influx-batch-bytes=N         size of a batch to send, up to 67108864\n"
+  "                                 (default: 65536)\n"
+  "  --influx-batch-ms=N            max age of a batch to send (default: 1000)\n"
+  "  --influx-gzip                  compress batches\n"
+  "  --influx-backoff-ms=N          delay before first retry of a failed batch,\n"
+  "                                 doubled after (default: 250)\n"
+  "  --influx-max-backoff-ms=N      limit of delay between retries (default: 30000)\n"
+  "  --influx-timeout-ms=N          timeout of network operations (default: 5000)\n"
+  "  --influx-max-pending-bytes=N   batches kept in memory while sending is stalled\n"
+  "                                 before spilling (default: 16777216)\n"
+  "  --influx-spill=PATH            file to spill undelivered batches to\n"
+  "  --help                         show this help message and exit\n"
+};
+
+
+static unsigned long long parse_number_or_halt(std::string_view name, std::string_view value) {
+  char* end{NULL};
+  const std::string text{value};
+  errno = 0;
+  const auto number = std::strtoull(text.c_str(), &end, 10);
+
+  // strtoull() silently negates values with leading minus
+  if (text.empty() || text[0] == '-' || *end != '\0' || errno == ERANGE) {
+    halt("invalid value of '" + std::string(name) + "': '" + text + "'");
+  }
+
+  return number;
+}
+
+
+static unsigned long long parse_number_or_halt(
+  std::string_view name,
+  std::string_view value,
+  const unsigned long long min,
+  const unsigned long long max
+) {
+  const auto number = parse_number_or_halt(name, value);
+
+  if (number < min || number > max) {
+    halt(
+      "value of '" + std::string(name) + "' must be in range " +
+      std::to_string(min) + ".." + std::to_string(max) + ": '" + std::string(value) + "'"
+    );
+  }
+
+  return number;
+}
+
+
+static std::vector<unsigned int> parse_cpus_or_halt(std::string_view name, std::string_view value) {
+  std::vector<unsigned int> cpus;
+
+  while (!value.empty()) {
+    const auto range = value.substr(0, value.find(','));
+    value.remove_prefix(std::min(range.size() + 1, value.size()));
+
+    const auto separator = range.find('-');
+    const auto first = parse_number_or_halt(name, range.substr(0, separator), 0, MAX_CPUS - 1);
+    const auto last = separator == std::string_view::npos ? first : parse_number_or_halt(name, range.substr(separator + 1), 0, MAX_CPUS - 1);
+
+    if (last < first) {
+      halt("invalid range of CPUs in '" + std::string(name) + "': '" + std::string(range) + "'");
+    }
+
+    for (auto cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(static_cast<unsigned int>(cpu));
+    }
+  }
+
+  if (cpus.empty()) {
+    halt("no CPUs listed in '" + std::string(name) + "'");
+  }
+
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  return cpus;
+}
+
+
+static sched_policy_t parse_sched_policy_or_halt(std::string_view name, std::string_view value) {
+  if (value == "other") return sched_policy_t::OTHER;
+  if (value == "batch") return sched_policy_t::BATCH;
+  if (value == "idle")  return sched_policy_t::IDLE;
+  if (value == "fifo")  return sched_policy_t::FIFO;
+  if (value == "rr")    return sched_policy_t::RR;
+
+  halt("invalid value of '" + std::string(name) + "': '" + std::string(value) + "'");
+  return sched_policy_t::OTHER;
+}
+
+
+void parse_influx_url_or_halt(std::string_view url, InfluxSink::config_t& config) {
+  if (url.substr(0, HTTP_SCHEME.size()) != HTTP_SCHEME) {
+    halt("InfluxDB URL must start with '" + std::string(HTTP_SCHEME) + "': '" + std::string(url) + "'");
+  }
+
+  auto authority = url.substr(HTTP_SCHEME.size());
+  const auto path_begin = authority.find('/');
+
+  config.path = path_begin == std::string_view::npos ? "/" : std::string(authority.substr(path_begin));
+  authority = authority.substr(0, path_begin);
+
+  config.port = HTTP_DEFAULT_PORT;
+  if (const auto port_begin = authority.rfind(':'); port_begin != std::string_view::npos) {
+    config.port = static_cast<unsigned short>(parse_number_or_halt("--influx-url", authority.substr(port_begin + 1), 1, 65535));
+    authority = authority.substr(0, port_begin);
+  }
+
+  if (authority.empty()) {
+    halt("InfluxDB URL has no host: '" + std::string(url) + "'");
+  }
+  config.host = authority;
+}
+
+
+options_t parse_options_or_halt(int argc, char* argv[]) {
+  options_t options;
+  InfluxSink::config_t influx;
+  bool has_influx{false};
+
+  for (int i{1}; i < argc; ++i) {
+    const std::string_view arg{argv[i]};
+    const auto separator = arg.find('=');
+    const auto name = arg.substr(0, separator);
+    const auto value = separator == std::string_view::npos ? std::string_view{} : arg.substr(separator + 1);
+
+    if (name == "--help") {
+      std::cout << USAGE;
+      halt(std::nullopt, 0);
+    } else if (name == "--polling-period-ms") {
+      options.polling_period = std::chrono::milliseconds(parse_number_or_halt(name, value));
+    } else if (name == "--overhead-report-ms") {
+      options.overhead_report_period = std::chrono::milliseconds(parse_number_or_halt(name, value));
+    } else if (name == "--cpus") {
+      options.placement.cpus = parse_cpus_or_halt(name, value);
+    } else if (name == "--avoid-gpu-job-cpus") {
+      options.placement.avoid_gpu_job_cpus = true;
+    } else if (name == "--sched-policy") {
+      options.placement.sched_policy = parse_sched_policy_or_halt(name, value);
+    } else if (name == "--sched-priority") {
+      options.placement.sched_priority = static_cast<int>(parse_number_or_halt(name, value, 1, 99));
+    } else if (name == "--influx-url") {
+      parse_influx_url_or_halt(value, influx);
+      has_influx = true;
+    } else if (name == "--influx-token") {
+      influx.token = value;
+    } else if (name == "--influx-batch-bytes") {
+      influx.batch_size = parse_number_or_halt(name, value, 1, INFLUX_MAX_BATCH_SIZE);
+    } else if (name == "--influx-batch-ms") {
+      influx.batch_period = std::chrono::milliseconds(parse_number_or_halt(name, value));
+    } else if (name == "--influx-gzip") {
+      influx.compress = true;
+    } else if (name == "--influx-backoff-ms") {
+      influx.retry_backoff = std::chrono::milliseconds(parse_number_or_halt(name, value));
+    } else if (name == "--influx-max-backoff-ms") {
+      influx.max_retry_backoff = std::chrono::milliseconds(parse_number_or_halt(name, value));
+    } else if (name == "--influx-timeout-ms") {
+      influx.timeout = std::chrono::milliseconds(parse_number_or_halt(name, value));
+    } else if (name == "--influx-max-pending-bytes") {
+      influx.max_pending_size = parse_number_or_halt(name, value);
+    } else if (name == "--influx-spill") {
+      influx.spill_path = value;
+    } else {
+      std::cerr << USAGE;
+      halt("unknown option: '" + std::string(arg) + "'");
+    }
+  }
+
+  const auto& sched_policy = options.placement.sched_policy;
+  const bool is_realtime_policy{
+    sched_policy.has_value() &&
+    (sched_policy.value() == sched_policy_t::FIFO || sched_policy.value() == sched_policy_t::RR)
+  };
+
+  if (is_realtime_policy && options.placement.sched_priority == 0) {
+    halt("'--sched-priority' is required for fifo and rr scheduling policies");
+  }
+
+  if (!is_realtime_policy && options.placement.sched_priority != 0) {
+    halt("'--sched-priority' is only applicable to fifo and rr scheduling policies");
+  }
+
+  if (options.polling_period.count() == 0) {
+    halt("polling period must be positive");
+  }
+
+  if (influx.batch_period.count() == 0) {
+    halt("InfluxDB batch period must be positive");
+  }
+
+  // zero disables socket timeouts, letting a hung server stall the writer
+  if (influx.timeout.count() == 0) {
+    halt("InfluxDB timeout must be positive");
+  }
+
+  if (influx.retry_backoff.count() == 0 || influx.max_retry_backoff < influx.retry_backoff) {
+    halt("InfluxDB retry backoff must be positive and not exceed its limit");
+  }
+
+  if (has_influx) {
+    options.influx = influx;
+  }
+
+  return options;
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef _NVIDIA_GPU_MONITOR_OPTIONS_H
+#define _NVIDIA_GPU_MONITOR_OPTIONS_H
+
+#include <chrono>
+#include <optional>
+
+#include "influx.h"
+#include "placement.h"
+
+
+constexpr auto DEFAULT_POLLING_PERIOD{std::chrono::milliseconds(250)};
+constexpr auto DEFAULT_OVERHEAD_REPORT_PERIOD{std::chrono::milliseconds(10000)};
+
+
+typedef struct options_st {
+  std::chrono::milliseconds polling_period{DEFAULT_POLLING_PERIOD};
+  std::chrono::milliseconds overhead_report_period{DEFAULT_OVERHEAD_REPORT_PERIOD}; // 0: disabled
+  ThreadPlacement::config_t placement;
+  std::optional<InfluxSink::config_t> influx;
+} options_t;
+
+
+options_t parse_options_or_halt(int argc, char* argv[]);
+
+// Fills host, port and path of the sink from "http://host[:port][/path]".
+void parse_influx_url_or_halt(std::string_view url, InfluxSink::config_t& config);
+
+
+#endif // _NVIDIA_GPU_MONITOR_OPTIONS_H
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include "overhead.h"
+
+
+ProcessOverheadMeter::ProcessOverheadMeter()
+: previous_usage{get_process_usage_or_halt()},
+  previous_measured_at{meter_clock_t::now()}
+{
+}
+
+
+ProcessOverheadMeter::~ProcessOverheadMeter() {
+}
+
+
+ProcessOverheadMeter::overhead_t ProcessOverheadMeter::measure_or_halt() {
+  const auto usage = get_process_usage_or_halt();
+  const auto measured_at = meter_clock_t::now();
+
+  const auto interval = std::chrono::duration_cast<std::chrono::microseconds>(measured_at - previous_measured_at);
+  const auto user_time = usage.user_time - previous_usage.user_time;
+  const auto system_time = usage.system_time - previous_usage.system_time;
+
+  const double cpu_percent = interval.count() > 0
+    ? 100.0 * static_cast<double>((user_time + system_time).count()) / static_cast<double>(interval.count())
+    : 0.0;
+
+  const overhead_t overhead{
+    std::chrono::duration_cast<std::chrono::milliseconds>(interval),
+    user_time,
+    system_time,
+    cpu_percent,
+    usage.voluntary_context_switches - previous_usage.voluntary_context_switches,
+    usage.involuntary_context_switches - previous_usage.involuntary_context_switches,
+    usage.rss,
+  };
+
+  previous_usage = usage;
+  previous_measured_at = measured_at;
+
+  return overhead;
+}
\ No newline at end of file
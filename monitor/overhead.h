@@ -0,0 +1,35 @@
+#ifndef _NVIDIA_GPU_MONITOR_OVERHEAD_H
+#define _NVIDIA_GPU_MONITOR_OVERHEAD_H
+
+#include <chrono>
+
+#include "proc.h"
+
+
+// Measures resources consumed by the monitor itself between measurements.
+class ProcessOverheadMeter {
+  public:
+    typedef struct overhead_st {
+      const std::chrono::milliseconds interval;
+      const std::chrono::microseconds user_time;
+      const std::chrono::microseconds system_time;
+      const double cpu_percent; // of a single CPU
+      const unsigned long long voluntary_context_switches;
+      const unsigned long long involuntary_context_switches;
+      const unsigned long long rss; // in kilobytes, at the end of interval
+    } overhead_t;
+
+    ProcessOverheadMeter();
+    ~ProcessOverheadMeter();
+
+    overhead_t measure_or_halt();
+
+  private:
+    typedef std::chrono::steady_clock meter_clock_t;
+
+    process_usage_t previous_usage;
+    meter_clock_t::time_point previous_measured_at;
+};
+
+
+#endif // _NVIDIA_GPU_MONITOR_OVERHEAD_H
\ No newline at end of file
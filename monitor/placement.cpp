@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <set>
+
+#include "placement.h"
+#include "utils.h"
+
+
+ThreadPlacement::ThreadPlacement(const config_t& config)
+: config{config},
+  allowed_cpus{config.cpus.empty() ? get_process_cpus_or_halt() : config.cpus},
+  can_resolve_gpu_jobs{is_in_root_pid_namespace()}
+{
+  // NVML reports IDs from the root PID namespace, which would match
+  // unrelated processes inside a container
+  if (config.avoid_gpu_job_cpus && !can_resolve_gpu_jobs) {
+    std::cerr << "monitor runs in a nested PID namespace and cannot resolve"
+              << " processes running on GPUs; CPUs of GPU jobs are not avoided" << std::endl;
+  }
+}
+
+
+ThreadPlacement::~ThreadPlacement() {
+}
+
+
+void ThreadPlacement::apply_or_halt(NVMLDeviceManager& device_manager) {
+  if (config.sched_policy.has_value() && !sched_policy_applied) {
+    set_process_sched_policy_or_halt(config.sched_policy.value(), config.sched_priority);
+    sched_policy_applied = true;
+  }
+
+  if (config.cpus.empty() && !config.avoid_gpu_job_cpus) {
+    return;
+  }
+
+  auto cpus = select_cpus_or_halt(device_manager);
+  if (cpus == applied_cpus) {
+    return;
+  }
+
+  if (applied_cpus.empty()) {
+    set_process_cpus_or_halt(cpus);
+  } else if (!maybe_set_process_cpus(cpus)) {
+    if (!failing) {
+      std::cerr << "failed to place monitor threads on CPUs " << format_cpus(cpus)
+                << "; keeping CPUs " << format_cpus(applied_cpus) << std::endl;
+      failing = true;
+    }
+    return;
+  }
+
+  failing = false;
+  applied_cpus = std::move(cpus);
+
+  std::cerr << "monitor threads placed on CPUs " << format_cpus(applied_cpus) << std::endl;
+}
+
+
+std::vector<unsigned int> ThreadPlacement::select_cpus_or_halt(NVMLDeviceManager& device_manager) const {
+  if (!config.avoid_gpu_job_cpus || !can_resolve_gpu_jobs) {
+    return allowed_cpus;
+  }
+
+  std::set<unsigned int> job_cpus;
+
+  for (auto device = device_manager.devices_begin(); device != device_manager.devices_end(); ++device) {
+    for (const auto pid : (*device).get_compute_process_ids_or_halt()) {
+      const auto cpus = maybe_get_process_cpus(static_cast<process_id_t>(pid));
+      job_cpus.insert(cpus.begin(), cpus.end());
+    }
+  }
+
+  std::vector<unsigned int> cpus;
+  std::copy_if(
+    allowed_cpus.begin(), allowed_cpus.end(), std::back_inserter(cpus),
+    [&job_cpus](const unsigned int cpu) { return job_cpus.count(cpu) == 0; }
+  );
+
+  // unpinned jobs may run anywhere, and the monitor has to run somewhere
+  return cpus.empty() ? allowed_cpus : cpus;
+}
+
+
+std::string format_cpus(const std::vector<unsigned int>& cpus) {
+  std::string value;
+
+  for (size_t i{0}; i < cpus.size(); ) {
+    size_t j{i};
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+      ++j;
+    }
+
+    if (!value.empty()) {
+      value.push_back(',');
+    }
+    value.append(std::to_string(cpus[i]));
+    if (j > i) {
+      value.append("-").append(std::to_string(cpus[j]));
+    }
+
+    i = j + 1;
+  }
+
+  return value;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef _NVIDIA_GPU_MONITOR_PLACEMENT_H
+#define _NVIDIA_GPU_MONITOR_PLACEMENT_H
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "nvml.h"
+#include "proc.h"
+
+
+// Keeps polling and writer threads of the monitor on configured CPUs and
+// under configured scheduling policy, optionally away from CPUs which
+// processes running on GPUs are allowed to use.
+class ThreadPlacement {
+  public:
+    typedef struct config_st {
+      std::vector<unsigned int> cpus; // empty: CPUs inherited by the monitor
+      bool avoid_gpu_job_cpus{false};
+      std::optional<sched_policy_t> sched_policy;
+      int sched_priority{0}; // 1..99 for FIFO and RR, 0 for the rest
+    } config_t;
+
+    ThreadPlacement(const config_t& config);
+    ~ThreadPlacement();
+
+    // Applies scheduling policy once and CPU affinity whenever it changes.
+    // Only the first placement is required to succeed; a later one which
+    // fails keeps threads where they are until the next call.
+    void apply_or_halt(NVMLDeviceManager& device_manager);
+
+  private:
+    std::vector<unsigned int> select_cpus_or_halt(NVMLDeviceManager& device_manager) const;
+
+    const config_t config;
+    const std::vector<unsigned int> allowed_cpus;
+    const bool can_resolve_gpu_jobs;
+
+    bool sched_policy_applied{false};
+    std::vector<unsigned int> applied_cpus;
+    bool failing{false};
+};
+
+
+std::string format_cpus(const std::vector<unsigned int>& cpus);
+
+
+#endif // _NVIDIA_GPU_MONITOR_PLACEMENT_H
\ No newline at end of file
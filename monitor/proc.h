@@ -0,0 +1,51 @@
+#ifndef _NVIDIA_GPU_MONITOR_PROC_H
+#define _NVIDIA_GPU_MONITOR_PROC_H
+
+#include <chrono>
+#include <vector>
+
+#include "config.h"
+
+
+#ifdef HAVE_WINDOWS_H
+  #include "proc_windows.h"
+#elif HAVE_SYS_RESOURCE_H
+  #include "proc_unix.h"
+#else
+  #error Unsupported target platform: neither <windows.h> nor <sys/resource.h> are present
+#endif
+
+
+enum class sched_policy_t {
+  OTHER,
+  BATCH,
+  IDLE,
+  FIFO,
+  RR,
+};
+
+
+typedef struct process_usage_st {
+  std::chrono::microseconds user_time;
+  std::chrono::microseconds system_time;
+  unsigned long long voluntary_context_switches;
+  unsigned long long involuntary_context_switches;
+  unsigned long long rss; // in kilobytes
+} process_usage_t;
+
+
+// Placement is applied to all threads of the current process.
+std::vector<unsigned int> get_process_cpus_or_halt();
+// union of CPUs allowed for any thread of a process
+std::vector<unsigned int> maybe_get_process_cpus(const process_id_t pid);
+// false if any thread could not be moved, errno or last error tells why
+bool maybe_set_process_cpus(const std::vector<unsigned int>& cpus);
+void set_process_cpus_or_halt(const std::vector<unsigned int>& cpus);
+void set_process_sched_policy_or_halt(const sched_policy_t policy, const int priority);
+
+// whether process IDs seen by the monitor are the ones seen by the driver
+bool is_in_root_pid_namespace();
+
+process_usage_t get_process_usage_or_halt();
+
+#endif // _NVIDIA_GPU_MONITOR_PROC_H
\ No newline at end of file
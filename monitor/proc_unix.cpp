@@ -0,0 +1,239 @@
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include <sched.h>
+#include <unistd.h>
+
+#ifdef __linux__
+  #include <dirent.h>
+  #include <sys/stat.h>
+#endif
+
+#include "proc.h"
+#include "utils.h"
+
+
+#ifdef __linux__
+
+// PROC_PID_INIT_INO of the kernel, fixed since Linux 3.8
+constexpr ino_t ROOT_PID_NAMESPACE_INODE{0xEFFFFFFC};
+
+
+// threads of a process are tasks listed in /proc/<pid>/task
+static std::optional<std::vector<pid_t>> maybe_get_thread_ids(const std::string& pid) {
+  std::vector<pid_t> ids;
+
+  DIR* tasks = opendir(("/proc/" + pid + "/task").c_str());
+  if (tasks == NULL) {
+    return std::nullopt;
+  }
+
+  for (auto entry = readdir(tasks); entry != NULL; entry = readdir(tasks)) {
+    if (entry->d_name[0] != '.') {
+      ids.push_back(static_cast<pid_t>(std::stoi(entry->d_name)));
+    }
+  }
+
+  closedir(tasks);
+  return ids;
+}
+
+
+static std::vector<pid_t> get_thread_ids_or_halt() {
+  auto ids = maybe_get_thread_ids("self");
+
+  if (!ids.has_value()) {
+    halt("failed to list threads of monitor: " + std::string(std::strerror(errno)));
+  }
+
+  return ids.value();
+}
+
+
+static std::vector<unsigned int> to_cpus(const cpu_set_t& set) {
+  std::vector<unsigned int> cpus;
+
+  for (unsigned int cpu{0}; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+    }
+  }
+
+  return cpus;
+}
+
+
+std::vector<unsigned int> get_process_cpus_or_halt() {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+    halt("failed to get CPU affinity of monitor: " + std::string(std::strerror(errno)));
+  }
+
+  return to_cpus(set);
+}
+
+
+std::vector<unsigned int> maybe_get_process_cpus(const process_id_t pid) {
+  cpu_set_t process_set;
+  CPU_ZERO(&process_set);
+
+  // frameworks tend to pin worker threads rather than the main one;
+  // process may also have exited meanwhile
+  const auto thread_ids = maybe_get_thread_ids(std::to_string(pid));
+  if (!thread_ids.has_value()) {
+    return {};
+  }
+
+  for (const auto thread_id : thread_ids.value()) {
+    cpu_set_t thread_set;
+    CPU_ZERO(&thread_set);
+
+    if (sched_getaffinity(thread_id, sizeof(thread_set), &thread_set) == 0) {
+      CPU_OR(&process_set, &process_set, &thread_set);
+    }
+  }
+
+  return to_cpus(process_set);
+}
+
+
+bool is_in_root_pid_namespace() {
+  struct stat namespace_stat;
+
+  // kernels without namespace files have no PID namespaces either
+  if (stat("/proc/self/ns/pid", &namespace_stat) != 0) {
+    return true;
+  }
+
+  return namespace_stat.st_ino == ROOT_PID_NAMESPACE_INODE;
+}
+
+
+bool maybe_set_process_cpus(const std::vector<unsigned int>& cpus) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+
+  for (const auto cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      errno = EINVAL;
+      return false;
+    }
+    CPU_SET(cpu, &set);
+  }
+
+  for (const auto thread_id : get_thread_ids_or_halt()) {
+    if (sched_setaffinity(thread_id, sizeof(set), &set) != 0 && errno != ESRCH) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+void set_process_cpus_or_halt(const std::vector<unsigned int>& cpus) {
+  if (!maybe_set_process_cpus(cpus)) {
+    halt("failed to set CPU affinity of monitor: " + std::string(std::strerror(errno)));
+  }
+}
+
+
+void set_process_sched_policy_or_halt(const sched_policy_t policy, const int priority) {
+  int native_policy{SCHED_OTHER};
+
+  switch (policy) {
+    case sched_policy_t::OTHER: native_policy = SCHED_OTHER; break;
+    case sched_policy_t::BATCH: native_policy = SCHED_BATCH; break;
+    case sched_policy_t::IDLE:  native_policy = SCHED_IDLE;  break;
+    case sched_policy_t::FIFO:  native_policy = SCHED_FIFO;  break;
+    case sched_policy_t::RR:    native_policy = SCHED_RR;    break;
+  }
+
+  sched_param param{};
+  param.sched_priority = priority;
+
+  for (const auto thread_id : get_thread_ids_or_halt()) {
+    if (sched_setscheduler(thread_id, native_policy, &param) != 0 && errno != ESRCH) {
+      halt("failed to set scheduling policy of monitor: " + std::string(std::strerror(errno)));
+    }
+  }
+}
+
+#else
+
+std::vector<unsigned int> get_process_cpus_or_halt() {
+  std::vector<unsigned int> cpus;
+
+  for (long cpu{0}; cpu < sysconf(_SC_NPROCESSORS_ONLN); ++cpu) {
+    cpus.push_back(static_cast<unsigned int>(cpu));
+  }
+
+  return cpus;
+}
+
+
+std::vector<unsigned int> maybe_get_process_cpus(const process_id_t) {
+  return {};
+}
+
+
+bool is_in_root_pid_namespace() {
+  return true;
+}
+
+
+bool maybe_set_process_cpus(const std::vector<unsigned int>&) {
+  errno = ENOSYS;
+  return false;
+}
+
+
+void set_process_cpus_or_halt(const std::vector<unsigned int>&) {
+  halt("setting CPU affinity is not supported on this platform");
+}
+
+
+void set_process_sched_policy_or_halt(const sched_policy_t, const int) {
+  halt("setting scheduling policy is not supported on this platform");
+}
+
+#endif
+
+
+static std::chrono::microseconds to_microseconds(const timeval& value) {
+  return std::chrono::seconds(value.tv_sec) + std::chrono::microseconds(value.tv_usec);
+}
+
+
+process_usage_t get_process_usage_or_halt() {
+  rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    halt("failed to get resource usage of monitor: " + std::string(std::strerror(errno)));
+  }
+
+  // ru_maxrss is a peak value, current one is only exposed by procfs
+  unsigned long long rss = static_cast<unsigned long long>(usage.ru_maxrss);
+
+#ifdef __linux__
+  unsigned long long size_pages{0};
+  unsigned long long resident_pages{0};
+
+  if (std::ifstream statm{"/proc/self/statm"}; statm >> size_pages >> resident_pages) {
+    rss = resident_pages * static_cast<unsigned long long>(sysconf(_SC_PAGESIZE)) / 1024;
+  }
+#endif
+
+  return process_usage_t{
+    to_microseconds(usage.ru_utime),
+    to_microseconds(usage.ru_stime),
+    static_cast<unsigned long long>(usage.ru_nvcsw),
+    static_cast<unsigned long long>(usage.ru_nivcsw),
+    rss,
+  };
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef _NVIDIA_GPU_MONITOR_PROC_UNIX_H
+#define _NVIDIA_GPU_MONITOR_PROC_UNIX_H
+
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+
+typedef pid_t process_id_t;
+
+#ifdef CPU_SETSIZE
+  constexpr unsigned int MAX_CPUS{CPU_SETSIZE};
+#else
+  constexpr unsigned int MAX_CPUS{1024};
+#endif
+
+
+#endif // _NVIDIA_GPU_MONITOR_PROC_UNIX_H
\ No newline at end of file
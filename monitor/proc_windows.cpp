@@ -0,0 +1,124 @@
+#include <string>
+
+#include <psapi.h>
+
+#include "proc.h"
+#include "utils.h"
+
+
+static std::vector<unsigned int> to_cpus(const DWORD_PTR mask) {
+  std::vector<unsigned int> cpus;
+
+  for (unsigned int cpu{0}; cpu < MAX_CPUS; ++cpu) {
+    if (mask & (static_cast<DWORD_PTR>(1) << cpu)) {
+      cpus.push_back(cpu);
+    }
+  }
+
+  return cpus;
+}
+
+
+std::vector<unsigned int> get_process_cpus_or_halt() {
+  DWORD_PTR process_mask;
+  DWORD_PTR system_mask;
+
+  if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+    halt("failed to get CPU affinity of monitor: error " + std::to_string(GetLastError()));
+  }
+
+  return to_cpus(process_mask);
+}
+
+
+std::vector<unsigned int> maybe_get_process_cpus(const process_id_t pid) {
+  HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+  if (process == NULL) {
+    return {};
+  }
+
+  DWORD_PTR process_mask{0};
+  DWORD_PTR system_mask{0};
+  const auto succeeded = GetProcessAffinityMask(process, &process_mask, &system_mask);
+  CloseHandle(process);
+
+  return succeeded ? to_cpus(process_mask) : std::vector<unsigned int>{};
+}
+
+
+bool is_in_root_pid_namespace() {
+  return true;
+}
+
+
+bool maybe_set_process_cpus(const std::vector<unsigned int>& cpus) {
+  DWORD_PTR mask{0};
+
+  for (const auto cpu : cpus) {
+    if (cpu >= MAX_CPUS) {
+      SetLastError(ERROR_INVALID_PARAMETER);
+      return false;
+    }
+    mask |= static_cast<DWORD_PTR>(1) << cpu;
+  }
+
+  return SetProcessAffinityMask(GetCurrentProcess(), mask) != 0;
+}
+
+
+void set_process_cpus_or_halt(const std::vector<unsigned int>& cpus) {
+  if (!maybe_set_process_cpus(cpus)) {
+    halt("failed to set CPU affinity of monitor: error " + std::to_string(GetLastError()));
+  }
+}
+
+
+// Windows has no per-thread policies, so they are mapped onto priority classes
+void set_process_sched_policy_or_halt(const sched_policy_t policy, const int) {
+  DWORD priority_class{NORMAL_PRIORITY_CLASS};
+
+  switch (policy) {
+    case sched_policy_t::OTHER: priority_class = NORMAL_PRIORITY_CLASS;       break;
+    case sched_policy_t::BATCH: priority_class = BELOW_NORMAL_PRIORITY_CLASS; break;
+    case sched_policy_t::IDLE:  priority_class = IDLE_PRIORITY_CLASS;         break;
+    case sched_policy_t::FIFO:  priority_class = HIGH_PRIORITY_CLASS;         break;
+    case sched_policy_t::RR:    priority_class = HIGH_PRIORITY_CLASS;         break;
+  }
+
+  if (!SetPriorityClass(GetCurrentProcess(), priority_class)) {
+    halt("failed to set scheduling policy of monitor: error " + std::to_string(GetLastError()));
+  }
+}
+
+
+static std::chrono::microseconds to_microseconds(const FILETIME& value) {
+  ULARGE_INTEGER ticks;
+  ticks.LowPart = value.dwLowDateTime;
+  ticks.HighPart = value.dwHighDateTime;
+
+  // FILETIME counts 100-nanosecond intervals
+  return std::chrono::microseconds(ticks.QuadPart / 10);
+}
+
+
+process_usage_t get_process_usage_or_halt() {
+  FILETIME created_at, exited_at, kernel_time, user_time;
+
+  if (!GetProcessTimes(GetCurrentProcess(), &created_at, &exited_at, &kernel_time, &user_time)) {
+    halt("failed to get CPU times of monitor: error " + std::to_string(GetLastError()));
+  }
+
+  PROCESS_MEMORY_COUNTERS memory{};
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory))) {
+    halt("failed to get memory usage of monitor: error " + std::to_string(GetLastError()));
+  }
+
+  // context switches are not exposed per process
+  return process_usage_t{
+    to_microseconds(user_time),
+    to_microseconds(kernel_time),
+    0,
+    0,
+    static_cast<unsigned long long>(memory.WorkingSetSize / 1024),
+  };
+}
\ No newline at end of file
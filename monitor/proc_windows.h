@@ -0,0 +1,10 @@
+#ifndef _NVIDIA_GPU_MONITOR_PROC_WINDOWS_H
+#define _NVIDIA_GPU_MONITOR_PROC_WINDOWS_H
+
+#include <windows.h>
+
+typedef DWORD process_id_t;
+
+constexpr unsigned int MAX_CPUS{sizeof(DWORD_PTR) * 8};
+
+#endif // _NVIDIA_GPU_MONITOR_PROC_WINDOWS_H
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include "http.h"
+#include "influx.h"
+#include "options.h"
+
+
+static int failures{0};
+
+#define CHECK(condition) \
+  if (!(condition)) { \
+    std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+    ++failures; \
+  }
+
+
+typedef struct canned_response_st {
+  std::string text;
+  bool close_after;
+} canned_response_t;
+
+
+// Serves canned responses one per request, sending each in two parts to
+// make the client assemble it from several reads.
+class StandInServer {
+  public:
+    StandInServer(const std::vector<canned_response_t>& responses): responses{responses} {
+      listener = socket(AF_INET, SOCK_STREAM, 0);
+
+      sockaddr_in address{};
+      address.sin_family = AF_INET;
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+      listen(listener, 1);
+
+      socklen_t length{sizeof(address)};
+      getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+      port = ntohs(address.sin_port);
+
+      server = std::thread{&StandInServer::serve, this};
+    }
+
+    ~StandInServer() {
+      wait();
+      close(listener);
+    }
+
+    void wait() {
+      if (server.joinable()) {
+        server.join();
+      }
+    }
+
+    unsigned short port{0};
+    unsigned int connections{0};
+
+  private:
+    void serve() {
+      int connection{-1};
+
+      for (const auto& response : responses) {
+        if (connection < 0) {
+          connection = accept(listener, NULL, NULL);
+          ++connections;
+        }
+
+        receive_request(connection);
+
+        const auto half = response.text.size() / 2;
+        send(connection, response.text.data(), half, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        send(connection, response.text.data() + half, response.text.size() - half, 0);
+
+        if (response.close_after) {
+          close(connection);
+          connection = -1;
+        }
+      }
+
+      if (connection >= 0) {
+        close(connection);
+      }
+    }
+
+    static void receive_request(int connection) {
+      std::string request;
+      char buffer[1024];
+      size_t headers_end{std::string::npos};
+
+      while ((headers_end = request.find("\r\n\r\n")) == std::string::npos) {
+        const auto received = recv(connection, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+          return;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+      }
+
+      const auto length_begin = request.find("Content-Length: ") + std::strlen("Content-Length: ");
+      const auto length = std::stoul(request.substr(length_begin));
+
+      while (request.size() < headers_end + 4 + length) {
+        const auto received = recv(connection, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+          return;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+      }
+    }
+
+    const std::vector<canned_response_t> responses;
+    int listener{-1};
+    std::thread server;
+};
+
+
+static void test_encode_device_line() {
+  const NVMLDevice::info_t info{
+    "GeForce GTX 950,x=y",
+    1,
+    NVMLDevice::energy_source_t::COUNTER,
+    NVMLDevice::metrics_t{10, 46, 12404, 75, 12, 1500, 250},
+  };
+
+  std::string buffer{"previous\n"};
+  encode_influx_line(buffer, std::chrono::milliseconds(1000), info);
+
+  CHECK(buffer ==
+    "previous\n"
+    "nvidia_gpu,index=1,name=GeForce\\ GTX\\ 950\\,x\\=y "
+    "fan_speed=10i,temperature=46i,power_usage=12404i,gpu_utilization=75i,memory_utilization=12i,"
+    "total_energy_mj=1500i,energy_delta_mj=250i "
+    "1000000000\n"
+  );
+}
+
+
+static void test_encode_overhead_line() {
+  const ProcessOverheadMeter::overhead_t overhead{
+    std::chrono::milliseconds(1000),
+    std::chrono::microseconds(300),
+    std::chrono::microseconds(200),
+    0.05,
+    12,
+    1,
+    4096,
+  };
+
+  std::string buffer;
+  encode_influx_line(buffer, std::chrono::milliseconds(2000), overhead);
+
+  CHECK(buffer.rfind("nvidia_gpu_monitor interval=1000i,user_time=300i,system_time=200i,cpu_percent=0.05", 0) == 0);
+  CHECK(buffer.find(",voluntary_context_switches=12i,involuntary_context_switches=1i,rss=4096i 2000000000\n") != std::string::npos);
+}
+
+
+static void test_parse_influx_url() {
+  InfluxSink::config_t config;
+
+  parse_influx_url_or_halt("http://localhost:8086/api/v2/write?org=o&bucket=b", config);
+  CHECK(config.host == "localhost");
+  CHECK(config.port == 8086);
+  CHECK(config.path == "/api/v2/write?org=o&bucket=b");
+
+  parse_influx_url_or_halt("http://influx.example", config);
+  CHECK(config.host == "influx.example");
+  CHECK(config.port == 80);
+  CHECK(config.path == "/");
+}
+
+
+static void test_http_responses() {
+  StandInServer server{{
+    {"HTTP/1.1 204 No Content\r\n\r\n", false},
+    {"HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello", false},
+    {"HTTP/1.1 200 OK\r\ntransfer-encoding: chunked\r\n\r\n5\r\nhello\r\n0\r\n\r\n", false},
+    {"HTTP/1.1 503 Service Unavailable\r\nContent-Length: 3\r\nConnection: close\r\n\r\nbad", true},
+    {"HTTP/1.1 200 OK\r\n\r\ndelimited by close", true},
+    {"HTTP/1.1 401 Unauthorized\r\nContent-Length: 0\r\n\r\n", false},
+  }};
+
+  HTTPConnection connection{"127.0.0.1", server.port, std::chrono::milliseconds(2000)};
+  const std::string body{"m f=1i 1\n"};
+
+  CHECK(connection.maybe_post("/write", "", body) == 204u);
+  CHECK(connection.maybe_post("/write", "", body) == 200u);
+  CHECK(connection.maybe_post("/write", "", body) == 200u);
+  CHECK(connection.maybe_post("/write", "", body) == 503u);
+  CHECK(connection.maybe_post("/write", "", body) == 200u);
+  CHECK(connection.maybe_post("/write", "Authorization: Token t\r\n", body) == 401u);
+
+  // connection is reused until server closes it
+  server.wait();
+  CHECK(server.connections == 3);
+}
+
+
+int main() {
+  test_encode_device_line();
+  test_encode_overhead_line();
+  test_parse_influx_url();
+  test_http_responses();
+
+  if (failures > 0) {
+    std::cerr << failures << " check(s) failed" << std::endl;
+    return 1;
+  }
+
+  std::cout << "all checks passed" << std::endl;
+  return 0;
+}
\ No newline at end of file